@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace pattern
+{
+
+/**
+ * @brief non-owning view of packed binary records, stand-in for std::span<const std::byte>
+ */
+struct RecordView
+{
+    const std::byte* data{nullptr};
+    std::size_t size{0};
+};
+
+/**
+ * @brief sequential reader over a RecordView
+ * @details every record is laid out as [std::uint32_t body size][key][args...],
+ * key and args are encoded with RecordCodec.
+ */
+class RecordReader final
+{
+public:
+    explicit RecordReader(RecordView view) noexcept
+        : mCurrent(view.data), mEnd(view.data + view.size)
+    {
+    }
+
+    [[ nodiscard ]] bool empty() const noexcept { return mCurrent == mEnd; }
+
+    /**
+     * @returns pointer to the next 'size' bytes and skips them
+     * @throws std::out_of_range if there are less than 'size' bytes left
+     */
+    const std::byte* take(std::size_t size)
+    {
+        if (static_cast<std::size_t>(mEnd - mCurrent) < size)
+        {
+            throw std::out_of_range("RecordReader: truncated record");
+        }
+        const auto* bytes = mCurrent;
+        mCurrent += size;
+        return bytes;
+    }
+
+    /**
+     * @returns body of the next record and skips it
+     * @throws std::out_of_range if the record is truncated
+     */
+    RecordView takeRecord()
+    {
+        std::uint32_t bodySize = 0;
+        std::memcpy(&bodySize, take(sizeof(bodySize)), sizeof(bodySize));
+        return {take(bodySize), bodySize};
+    }
+
+private:
+    const std::byte* mCurrent;
+    const std::byte* mEnd;
+};
+
+/**
+ * @brief encodes and decodes values of type T in packed records
+ * @details specialize it for your own key and argument types. Provided for arithmetic and enum types
+ * (native byte order), bool, std::string and std::string_view (std::uint32_t length followed by characters).
+ * Decoding std::string_view doesn't copy: the view points into the record buffer.
+ */
+template<typename T, typename = void>
+struct RecordCodec;
+
+template<typename T>
+struct RecordCodec<T, std::enable_if_t<(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T>>>
+{
+    static void encode(std::vector<std::byte>& buffer, T value)
+    {
+        const auto offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    static T decode(RecordReader& reader)
+    {
+        T value;
+        std::memcpy(&value, reader.take(sizeof(T)), sizeof(T));
+        return value;
+    }
+};
+
+/**
+ * @details bool is stored as one byte, any value other than 0 or 1 is malformed
+ */
+template<>
+struct RecordCodec<bool>
+{
+    static void encode(std::vector<std::byte>& buffer, bool value)
+    {
+        buffer.push_back(value ? std::byte{1} : std::byte{0});
+    }
+
+    static bool decode(RecordReader& reader)
+    {
+        const auto value = *reader.take(1);
+        if (value != std::byte{0} && value != std::byte{1})
+        {
+            throw std::invalid_argument("RecordCodec: malformed bool");
+        }
+        return value == std::byte{1};
+    }
+};
+
+template<>
+struct RecordCodec<std::string_view>
+{
+    static void encode(std::vector<std::byte>& buffer, std::string_view value)
+    {
+        RecordCodec<std::uint32_t>::encode(buffer, static_cast<std::uint32_t>(value.size()));
+        const auto offset = buffer.size();
+        buffer.resize(offset + value.size());
+        std::memcpy(buffer.data() + offset, value.data(), value.size());
+    }
+
+    static std::string_view decode(RecordReader& reader)
+    {
+        const auto size = RecordCodec<std::uint32_t>::decode(reader);
+        return {reinterpret_cast<const char*>(reader.take(size)), size};
+    }
+};
+
+template<>
+struct RecordCodec<std::string>
+{
+    static void encode(std::vector<std::byte>& buffer, const std::string& value)
+    {
+        RecordCodec<std::string_view>::encode(buffer, value);
+    }
+
+    static std::string decode(RecordReader& reader)
+    {
+        return std::string(RecordCodec<std::string_view>::decode(reader));
+    }
+};
+
+/**
+ * @details appends a record with key and args to buffer
+ * @example
+ * std::vector<std::byte> buffer;
+ * pattern::writeRecord(buffer, std::string("concrete"), 2, 3);
+ * auto object = factory.createFromRecord({buffer.data(), buffer.size()});
+ */
+template<typename KeyT, typename... ArgsT>
+void writeRecord(std::vector<std::byte>& buffer, const KeyT& key, const ArgsT&... args)
+{
+    const auto sizeOffset = buffer.size();
+    RecordCodec<std::uint32_t>::encode(buffer, 0);
+    RecordCodec<KeyT>::encode(buffer, key);
+    (RecordCodec<ArgsT>::encode(buffer, args), ...);
+    const auto bodySize = static_cast<std::uint32_t>(buffer.size() - sizeOffset - sizeof(std::uint32_t));
+    std::memcpy(buffer.data() + sizeOffset, &bodySize, sizeof(bodySize));
+}
+
+/**
+ * @details splits buffer into at most 'parts' views of roughly equal size on record boundaries,
+ * e.g. to process them with createAll from several threads.
+ * A truncated tail is kept in the last view.
+ */
+inline std::vector<RecordView> splitRecords(RecordView buffer, std::size_t parts)
+{
+    std::vector<RecordView> views;
+    if (parts == 0 || buffer.size == 0)
+    {
+        return views;
+    }
+    const auto partSize = (buffer.size + parts - 1) / parts;
+    RecordReader reader(buffer);
+    const auto* partBegin = buffer.data;
+    try
+    {
+        while (!reader.empty())
+        {
+            const auto record = reader.takeRecord();
+            const auto* recordEnd = record.data + record.size;
+            if (static_cast<std::size_t>(recordEnd - partBegin) >= partSize)
+            {
+                views.push_back({partBegin, static_cast<std::size_t>(recordEnd - partBegin)});
+                partBegin = recordEnd;
+            }
+        }
+    } catch (const std::out_of_range&) {}
+    const auto* bufferEnd = buffer.data + buffer.size;
+    if (partBegin != bufferEnd)
+    {
+        views.push_back({partBegin, static_cast<std::size_t>(bufferEnd - partBegin)});
+    }
+    return views;
+}
+
+} // namespace pattern
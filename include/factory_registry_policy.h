@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+namespace pattern
+{
+namespace registry_policy
+{
+
+/**
+ * @brief stores registred types in std::unordered_multimap
+ */
+struct Hash {};
+
+/**
+ * @brief stores registred types in a packed structure-of-arrays and finds keys by a vectorized linear scan.
+ * @details Fast for factories with few products and short string or integral keys.
+ */
+struct Small {};
+
+/**
+ * @brief starts with Small registry and switches to Hash once more than SmallLimit distinct keys are registred
+ */
+template<std::size_t SmallLimit = 32>
+struct Auto {};
+
+} // namespace registry_policy
+
+/**
+ * @brief selects the registry backend of a factory
+ * @tparam BaseT base type of the factory
+ * @tparam KeyT key type of the factory
+ * @details specialize it to choose the backend explicitly, registry_policy::Auto is used by default.
+ * The specialization must be visible in every translation unit (and shared library) before the factory
+ * is instantiated, e.g. next to the factory declaration, otherwise factory layouts differ between them.
+ * @example
+ * template<>
+ * struct pattern::FactoryRegistryPolicy<Interface, std::string> { using type = pattern::registry_policy::Hash; };
+ */
+template<typename BaseT, typename KeyT>
+struct FactoryRegistryPolicy
+{
+    using type = registry_policy::Auto<>;
+};
+
+} // namespace pattern
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "private/factory_replica_impl.h"
+#include <cassert>
+
+namespace pattern
+{
+
+/**
+ * @brief ReplicaTopology describes groups of cpus which get their own read-only registry replica.
+ * @details Threads are routed to the group of the cpu they run on, unless they are bound to a group
+ * explicitly with ReplicaGroupScope.
+ * @example
+ * InterfaceFactory::replicate(ReplicaTopology::numaNodes());
+ * InterfaceFactory::replicate(ReplicaTopology::emulated(4));
+ * @sa StaticHGSFactory::replicate
+ */
+class ReplicaTopology final
+{
+public:
+    ReplicaTopology() = default;
+
+    /**
+     * @param cpuGroups cpus of every group, a group may have no cpus, then it is reachable only via ReplicaGroupScope
+     */
+    explicit ReplicaTopology(std::vector<std::vector<int>> cpuGroups)
+        : mCpuGroups(std::move(cpuGroups))
+    {
+        for (std::size_t group = 0; group < mCpuGroups.size(); ++group)
+        {
+            for (const auto cpu : mCpuGroups[group])
+            {
+                if (cpu < 0)
+                {
+                    continue;
+                }
+                if (static_cast<std::size_t>(cpu) >= mCpuToGroup.size())
+                {
+                    mCpuToGroup.resize(static_cast<std::size_t>(cpu) + 1, 0);
+                }
+                mCpuToGroup[static_cast<std::size_t>(cpu)] = group;
+            }
+        }
+    }
+
+    /**
+     * @returns one group per numa node or a single group if the topology can't be read
+     */
+    static ReplicaTopology numaNodes()
+    {
+        auto nodes = impl_pattern::readNumaNodeCpus();
+        if (nodes.empty())
+        {
+            nodes.emplace_back();
+        }
+        return ReplicaTopology(std::move(nodes));
+    }
+
+    /**
+     * @returns groupCount groups with cpus distributed round-robin, e.g. to test replication on a single node
+     */
+    static ReplicaTopology emulated(std::size_t groupCount)
+    {
+        std::vector<std::vector<int>> groups(groupCount > 0 ? groupCount : 1);
+        const auto cpuCount = std::thread::hardware_concurrency();
+        for (unsigned cpu = 0; cpu < cpuCount; ++cpu)
+        {
+            groups[cpu % groups.size()].push_back(static_cast<int>(cpu));
+        }
+        return ReplicaTopology(std::move(groups));
+    }
+
+    [[ nodiscard ]] std::size_t groupCount() const noexcept { return mCpuGroups.size(); }
+
+    [[ nodiscard ]] const std::vector<int>& cpus(std::size_t group) const { return mCpuGroups.at(group); }
+
+    /**
+     * @returns group of the current thread: the one bound by ReplicaGroupScope or the group of its cpu
+     * @details binding to a group which doesn't exist produces assertion, without assertions group 0 is used
+     */
+    [[ nodiscard ]] std::size_t currentGroup() const noexcept
+    {
+        if (mCpuGroups.empty())
+        {
+            return 0;
+        }
+        if (const auto group = impl_pattern::currentReplicaGroupOverride(); group != impl_pattern::kNoReplicaGroup)
+        {
+            assert(((void)"ReplicaGroupScope is bound to a group which doesn't exist", group < mCpuGroups.size()));
+            return group < mCpuGroups.size() ? group : 0;
+        }
+        const auto cpu = impl_pattern::currentCpu();
+        if (cpu >= 0 && static_cast<std::size_t>(cpu) < mCpuToGroup.size())
+        {
+            return mCpuToGroup[static_cast<std::size_t>(cpu)];
+        }
+        return 0;
+    }
+
+private:
+    std::vector<std::vector<int>> mCpuGroups;
+    std::vector<std::size_t> mCpuToGroup;
+};
+
+/**
+ * @brief binds the current thread to a replica group for the scope lifetime
+ * @example
+ * std::thread worker([] {
+ *     ReplicaGroupScope scope(1);
+ *     auto object = InterfaceFactory::create("concrete");
+ * });
+ */
+class ReplicaGroupScope final
+{
+public:
+    explicit ReplicaGroupScope(std::size_t group) noexcept
+        : mPreviousGroup(impl_pattern::currentReplicaGroupOverride())
+    {
+        impl_pattern::currentReplicaGroupOverride() = group;
+    }
+
+    ~ReplicaGroupScope()
+    {
+        impl_pattern::currentReplicaGroupOverride() = mPreviousGroup;
+    }
+
+    ReplicaGroupScope(const ReplicaGroupScope&) = delete;
+    ReplicaGroupScope& operator=(const ReplicaGroupScope&) = delete;
+    ReplicaGroupScope(ReplicaGroupScope&&) = delete;
+    ReplicaGroupScope& operator=(ReplicaGroupScope&&) = delete;
+
+private:
+    std::size_t mPreviousGroup;
+};
+
+} // namespace pattern
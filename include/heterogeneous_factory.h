@@ -1,6 +1,8 @@
 #pragma once
 
 #include "private/heterogeneous_factory_impl.h"
+#include "poly_value.h"
+#include "factory_record.h"
 
 namespace pattern
 {
@@ -13,6 +15,8 @@ namespace pattern
  * @details HGSFactory can be used as a simple object and via inheritance.
  * Also there is a macro REGISTER_IN_FACTORY_INSTANCE_STATICALLY, for handy types registration in static context
  * if you have e.g. singleton of your factory.
+ * The registry backend is chosen by FactoryRegistryPolicy<BaseT, KeyT> specialization, which must be visible
+ * in every translation unit before the factory is instantiated, otherwise the program is ill-formed.
  * @example
  * HGSFactory<Interface, std::string, int> factory;
  * class InterfaceFactory : public HGSFactory<Interface, Hashable, int, double, std::string> {}
@@ -45,6 +49,57 @@ public:
         return impl.create(factoryRegistrationKey, std::forward<CreationArgsT>(args)...);
     }
 
+    /**
+     * @tparam InlineSize size in bytes of the inline storage of the returned PolyValue
+     * @tparam CreationArgsT argument types passed to an object's ctor
+     * @param factoryRegistrationKey key of registred type
+     * @param args... parameters passed to an object's ctor
+     * @details creates an object by its register name with arguments without heap allocation
+     * if the object fits InlineSize, @sa PolyValue
+     * @returns PolyValue<BaseT, InlineSize> owning the object if it is successfully constructed, empty otherwise
+     * @example
+     * auto object = factory.createValue<32>("concreteName", 1, 2);
+     */
+    template<std::size_t InlineSize, typename... CreationArgsT>
+    [[ nodiscard ]] PolyValue<BaseT, InlineSize> createValue(KeyT factoryRegistrationKey,
+                                                             CreationArgsT... args) const noexcept
+    {
+        return impl.template createValue<InlineSize>(factoryRegistrationKey, std::forward<CreationArgsT>(args)...);
+    }
+
+    /**
+     * @param record single packed record [std::uint32_t body size][key][args...] @sa RecordCodec, writeRecord
+     * @details decodes the key and constructor arguments from the record and constructs the object from them.
+     * Types are created with the arguments they were registred with or, if those are the default ones,
+     * with DefaultCreationArgsT. All of them must have RecordCodec specialization.
+     * std::string keys and std::string_view args are read in place, a std::string key is copied only
+     * by the hash registry backend (registry_policy::Hash or Auto past its limit).
+     * @returns std::unique_ptr<BasePtrT> if object is successfully constructed,
+     * nullptr if the key is unknown or the record is malformed
+     * @example
+     * auto object = factory.createFromRecord({buffer.data(), buffer.size()});
+     */
+    [[ nodiscard ]] BasePtrT createFromRecord(RecordView record) const noexcept
+    {
+        return impl.createFromRecord(record);
+    }
+
+    /**
+     * @tparam SinkT callable accepting std::unique_ptr<BaseT>
+     * @param buffer sequence of packed records
+     * @param sink receives an object, or nullptr if it can't be created, for every record in order
+     * @details streaming version of createFromRecord, stops at a truncated record
+     * @returns number of records passed to sink
+     * @throws whatever sink throws
+     * @example
+     * factory.createAll({buffer.data(), buffer.size()}, [&](auto object) { objects.push_back(std::move(object)); });
+     */
+    template<typename SinkT>
+    std::size_t createAll(RecordView buffer, SinkT&& sink) const
+    {
+        return impl.createAll(buffer, std::forward<SinkT>(sink));
+    }
+
     /**
      * @tparam T type to register in factory
      * @tparam RegisterArgsT argument types for registred types construction
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "private/heterogeneous_static_factory_impl.h"
+#include "poly_value.h"
+#include "factory_record.h"
+#include "factory_replica_topology.h"
 
 namespace pattern
 {
@@ -17,6 +20,8 @@ namespace pattern
  * 1) WHEN you don't have separate library where your factory is supposed to be located,
  * 2) WHEN there is no risk to meet the static initialization order fiasco,
  * 3) FOR handy automatic static types registration via REGISTER_IN_STATIC_FACTORY macro without adding any extra code.
+ * The registry backend is chosen by FactoryRegistryPolicy<BaseT, KeyT> specialization, which must be visible
+ * in every translation unit before the factory is instantiated, otherwise the program is ill-formed.
  * @example
  * using InterfaceFactory = StaticHGSFactory<Interface, std::string, int>;
  * class InterfaceFactory : public StaticHGSFactory<Interface, Hashable, int, double, std::string> {}
@@ -46,6 +51,56 @@ public:
         return ImplStaticFactory::create(factoryRegistrationKey, args...);
     }
 
+    /**
+     * @tparam InlineSize size in bytes of the inline storage of the returned PolyValue
+     * @tparam CreationArgsT argument types passed to an object's ctor
+     * @param factoryRegistrationKey key of registred type
+     * @param args... parameters passed to an object's ctor
+     * @details creates an object by its register name with arguments without heap allocation
+     * if the object fits InlineSize, @sa PolyValue
+     * @returns PolyValue<BaseT, InlineSize> owning the object if it is successfully constructed, empty otherwise
+     * @example
+     * auto object = InterfaceFactory::createValue<32>("concreteName", 1, 2);
+     */
+    template<std::size_t InlineSize, typename... CreationArgsT>
+    static PolyValue<BaseT, InlineSize> createValue(KeyT factoryRegistrationKey, CreationArgsT... args) noexcept
+    {
+        return ImplStaticFactory::template createValue<InlineSize>(factoryRegistrationKey, args...);
+    }
+
+    /**
+     * @param record single packed record [std::uint32_t body size][key][args...] @sa RecordCodec, writeRecord
+     * @details decodes the key and constructor arguments from the record and constructs the object from them.
+     * Types are created with the arguments they were registred with or, if those are the default ones,
+     * with DefaultCreationArgsT. All of them must have RecordCodec specialization.
+     * std::string keys and std::string_view args are read in place, a std::string key is copied only
+     * by the hash registry backend (registry_policy::Hash or Auto past its limit).
+     * @returns std::unique_ptr<BasePtrT> if object is successfully constructed,
+     * nullptr if the key is unknown or the record is malformed
+     * @example
+     * auto object = InterfaceFactory::createFromRecord({buffer.data(), buffer.size()});
+     */
+    static BasePtrT createFromRecord(RecordView record) noexcept
+    {
+        return ImplStaticFactory::createFromRecord(record);
+    }
+
+    /**
+     * @tparam SinkT callable accepting std::unique_ptr<BaseT>
+     * @param buffer sequence of packed records
+     * @param sink receives an object, or nullptr if it can't be created, for every record in order
+     * @details streaming version of createFromRecord, stops at a truncated record
+     * @returns number of records passed to sink
+     * @throws whatever sink throws
+     * @example
+     * InterfaceFactory::createAll({buffer.data(), buffer.size()}, [&](auto object) { objects.push_back(std::move(object)); });
+     */
+    template<typename SinkT>
+    static std::size_t createAll(RecordView buffer, SinkT&& sink)
+    {
+        return ImplStaticFactory::createAll(buffer, std::forward<SinkT>(sink));
+    }
+
     /**
      * @tparam T type to register in factory
      * @tparam RegisterArgsT argument types for registred types construction
@@ -60,6 +115,34 @@ public:
         ImplStaticFactory::template registerType<T, RegisterArgsT...>();
     }
 
+    /**
+     * @param topology groups of cpus which get their own registry replica @sa ReplicaTopology
+     * @details opt-in replication for multi-socket machines: copies the registry once per group
+     * into pages mapped for that replica alone, from a thread pinned to the group cpus, so the replica containers
+     * and creators are placed on its numa node by first touch. Keys which allocate on their own
+     * (std::string longer than its inline buffer) stay on the general heap.
+     * Afterwards create calls read the replica of the current thread group.
+     * Must be called after all types are registred and before concurrent creation starts.
+     * If copying fails the factory keeps using the single registry. If a replica thread can't be pinned,
+     * e.g. the group has no cpus or they are outside of the process cpuset, the replica is still built and used,
+     * but its memory placement is left to the OS.
+     * @returns true if every replica was built by a pinned thread, false otherwise
+     * @example
+     * InterfaceFactory::replicate(ReplicaTopology::numaNodes());
+     */
+    static bool replicate(const ReplicaTopology& topology = ReplicaTopology::numaNodes()) noexcept
+    {
+        return ImplStaticFactory::replicate(topology);
+    }
+
+    /**
+     * @returns number of registry replicas, 0 if the factory isn't replicated
+     */
+    static std::size_t replicaCount() noexcept
+    {
+        return ImplStaticFactory::replicaCount();
+    }
+
 public:
     StaticHGSFactory() = delete;
     virtual ~StaticHGSFactory() = default;
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "private/poly_value_impl.h"
+
+namespace pattern
+{
+
+/**
+ * @brief PolyValue owns a polymorphic object created by a factory and keeps it inline when it fits.
+ * @tparam BaseT base type of the owned object, must have a virtual destructor
+ * @tparam InlineSize size of the inline storage in bytes
+ * @details Objects whose size fits InlineSize, whose alignment does not exceed alignof(std::max_align_t)
+ * and which are nothrow move constructible are constructed inside the PolyValue itself,
+ * other objects are allocated on the heap. Access always goes through BaseT, so virtual dispatch is kept.
+ * PolyValue is move only, moving an inline object relocates it with the hooks recorded by the factory.
+ * @example
+ * auto object = factory.createValue<32>("concreteName", 1, 2);
+ * if (object) object->doSomething();
+ * @sa HGSFactory::createValue, StaticHGSFactory::createValue
+ */
+template<typename BaseT, std::size_t InlineSize>
+class PolyValue final
+{
+    static_assert(std::has_virtual_destructor_v<BaseT>, "Type 'BaseT' must have a virtual destructor");
+
+    using OpsT = impl_pattern::PolyValueTypeOps<BaseT>;
+
+public:
+    PolyValue() noexcept = default;
+
+    PolyValue(PolyValue&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    PolyValue& operator=(PolyValue&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    PolyValue(const PolyValue&) = delete;
+    PolyValue& operator=(const PolyValue&) = delete;
+
+    ~PolyValue()
+    {
+        reset();
+    }
+
+    /**
+     * @details destroys the owned object, PolyValue becomes empty
+     */
+    void reset() noexcept
+    {
+        if (mOps)
+        {
+            mOps->destroy(mStorage);
+        }
+        else
+        {
+            delete mObject;
+        }
+        mObject = nullptr;
+        mOps = nullptr;
+    }
+
+    /**
+     * @returns true if the owned object lives in the inline storage
+     */
+    [[ nodiscard ]] bool isInline() const noexcept { return mOps != nullptr; }
+
+    [[ nodiscard ]] BaseT* get() const noexcept { return mObject; }
+    BaseT* operator->() const noexcept { return mObject; }
+    BaseT& operator*() const noexcept { return *mObject; }
+    explicit operator bool() const noexcept { return mObject != nullptr; }
+
+private:
+    void moveFrom(PolyValue& other) noexcept
+    {
+        if (other.mOps)
+        {
+            mObject = other.mOps->relocate(other.mStorage, mStorage);
+        }
+        else
+        {
+            mObject = other.mObject;
+        }
+        mOps = other.mOps;
+        other.mObject = nullptr;
+        other.mOps = nullptr;
+    }
+
+private:
+    alignas(impl_pattern::kPolyValueAlignment) std::byte mStorage[InlineSize > 0 ? InlineSize : 1];
+    BaseT* mObject{nullptr};
+    const OpsT* mOps{nullptr};
+
+private:
+    friend struct impl_pattern::PolyValueAccess;
+};
+
+} // namespace pattern
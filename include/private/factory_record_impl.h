@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../factory_record.h"
+#include <memory>
+#include <tuple>
+
+namespace impl_pattern
+{
+namespace traits
+{
+
+template<typename T, typename = std::void_t<>>
+struct is_record_decodable : std::false_type {};
+
+template<typename T>
+struct is_record_decodable<T, std::void_t<
+        decltype(
+            pattern::RecordCodec<T>::decode(std::declval<pattern::RecordReader&>())
+        )
+>> : std::true_type {};
+
+template<typename... T>
+constexpr bool are_record_decodable_v = (is_record_decodable<std::decay_t<T>>::value && ...);
+
+} // namespace traits
+
+/**
+ * @details decodes Args from reader in order and constructs RegistredT from them
+ * @throws std::out_of_range if the record is truncated, whatever RegistredT constructor throws
+ */
+template<typename BaseT, class RegistredT, typename... Args>
+std::unique_ptr<BaseT> makeFromRecord(pattern::RecordReader& reader)
+{
+    // braced initialization guarantees left to right decoding order
+    std::tuple<std::decay_t<Args>...> args{pattern::RecordCodec<std::decay_t<Args>>::decode(reader)...};
+    return std::apply([](auto&&... decodedArgs)
+    {
+        return std::make_unique<RegistredT>(std::forward<decltype(decodedArgs)>(decodedArgs)...);
+    }, std::move(args));
+}
+
+} // namespace impl_pattern
@@ -0,0 +1,565 @@
+#pragma once
+
+#include "../factory_registry_policy.h"
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// SIMD paths depend only on the target architecture, not on per translation unit ISA flags:
+// AVX2 is compiled via target attribute and picked at runtime, SSE2 is the x86-64 baseline
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define IMPL_PATTERN_REGISTRY_AVX2 1
+#define IMPL_PATTERN_REGISTRY_SSE2 1
+#elif defined(_M_X64)
+#include <emmintrin.h>
+#define IMPL_PATTERN_REGISTRY_SSE2 1
+#endif
+
+namespace impl_pattern
+{
+
+/**
+ * @brief packs a key into 64 bits so that equal keys always have equal digests
+ * @details integral keys are stored as is, strings as their length and up to 7 characters
+ * (whole short strings, first 3 and last 4 characters of longer ones), other keys fall back to std::hash.
+ */
+template<typename KeyT, typename = void>
+struct RegistryKeyDigest
+{
+    static std::uint64_t get(const KeyT& key)
+    {
+        return static_cast<std::uint64_t>(std::hash<KeyT>{}(key));
+    }
+};
+
+template<typename KeyT>
+struct RegistryKeyDigest<KeyT, std::enable_if_t<std::is_integral_v<KeyT> || std::is_enum_v<KeyT>>>
+{
+    static std::uint64_t get(const KeyT& key) noexcept
+    {
+        return static_cast<std::uint64_t>(key);
+    }
+};
+
+template<typename KeyT>
+struct RegistryKeyDigest<KeyT, std::enable_if_t<std::is_same_v<KeyT, std::string>
+                                                || std::is_same_v<KeyT, std::string_view>>>
+{
+    static std::uint64_t get(const KeyT& key) noexcept
+    {
+        constexpr std::size_t kCharsSize = sizeof(std::uint64_t) - 1;
+        constexpr std::size_t kHeadSize = 3;
+        std::uint64_t chars = 0;
+        if (key.size() <= kCharsSize)
+        {
+            std::memcpy(&chars, key.data(), key.size());
+        }
+        else
+        {
+            auto* bytes = reinterpret_cast<unsigned char*>(&chars);
+            std::memcpy(bytes, key.data(), kHeadSize);
+            std::memcpy(bytes + kHeadSize, key.data() + key.size() - (kCharsSize - kHeadSize), kCharsSize - kHeadSize);
+        }
+        return (chars << 8) | (key.size() & 0xFF);
+    }
+};
+
+inline std::size_t findRegistryDigestScalar(const std::uint64_t* digests, std::size_t count,
+                                            std::uint64_t digest, std::size_t from) noexcept
+{
+    for (auto i = from; i < count; ++i)
+    {
+        if (digests[i] == digest)
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
+#if defined(IMPL_PATTERN_REGISTRY_SSE2)
+inline std::size_t findRegistryDigestSse2(const std::uint64_t* digests, std::size_t count,
+                                          std::uint64_t digest, std::size_t from) noexcept
+{
+    // SSE2 has no 64 bit compare: compare 32 bit halves and require both of them to match
+    std::size_t i = from;
+    const __m128i needle = _mm_set1_epi64x(static_cast<long long>(digest));
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(digests + i));
+        const __m128i halves = _mm_cmpeq_epi32(block, needle);
+        const __m128i equal = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        const int mask = _mm_movemask_pd(_mm_castsi128_pd(equal));
+        if (mask != 0)
+        {
+            return i + ((mask & 1) ? 0 : 1);
+        }
+    }
+    return findRegistryDigestScalar(digests, count, digest, i);
+}
+#endif
+
+#if defined(IMPL_PATTERN_REGISTRY_AVX2)
+__attribute__((target("avx2")))
+inline std::size_t findRegistryDigestAvx2(const std::uint64_t* digests, std::size_t count,
+                                          std::uint64_t digest, std::size_t from) noexcept
+{
+    std::size_t i = from;
+    const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(digest));
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(digests + i));
+        const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, needle)));
+        if (mask != 0)
+        {
+            for (std::size_t lane = 0;; ++lane)
+            {
+                if (mask & (1 << lane))
+                {
+                    return i + lane;
+                }
+            }
+        }
+    }
+    return findRegistryDigestScalar(digests, count, digest, i);
+}
+
+inline bool hasRegistryAvx2() noexcept
+{
+    static const bool supported = []
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+}
+#endif
+
+/**
+ * @returns index of the first digest equal to 'digest' in [from, count) or count if there is none
+ */
+inline std::size_t findRegistryDigest(const std::uint64_t* digests, std::size_t count,
+                                      std::uint64_t digest, std::size_t from) noexcept
+{
+#if defined(IMPL_PATTERN_REGISTRY_AVX2)
+    if (hasRegistryAvx2())
+    {
+        return findRegistryDigestAvx2(digests, count, digest, from);
+    }
+#endif
+#if defined(IMPL_PATTERN_REGISTRY_SSE2)
+    return findRegistryDigestSse2(digests, count, digest, from);
+#else
+    return findRegistryDigestScalar(digests, count, digest, from);
+#endif
+}
+
+using RegistryAllocatorT = std::pmr::polymorphic_allocator<std::byte>;
+
+/**
+ * @brief type-erased registry value which, unlike std::any, allocates the value from the registry memory resource
+ * @details lets a registry be copied with all its values into memory of a given resource, e.g. a replica arena
+ */
+class RegistryTrait final
+{
+    struct Ops
+    {
+        const std::type_info& type;
+        void* (*copy)(const void* from, std::pmr::memory_resource* resource);
+        void (*destroy)(void* object, std::pmr::memory_resource* resource) noexcept;
+    };
+
+    template<typename T>
+    struct OpsHolder
+    {
+        template<typename U>
+        static void* create(U&& value, std::pmr::memory_resource* resource)
+        {
+            void* object = resource->allocate(sizeof(T), alignof(T));
+            try
+            {
+                return ::new (object) T(std::forward<U>(value));
+            } catch (...)
+            {
+                resource->deallocate(object, sizeof(T), alignof(T));
+                throw;
+            }
+        }
+
+        static void* copy(const void* from, std::pmr::memory_resource* resource)
+        {
+            return create(*static_cast<const T*>(from), resource);
+        }
+
+        static void destroy(void* object, std::pmr::memory_resource* resource) noexcept
+        {
+            static_cast<T*>(object)->~T();
+            resource->deallocate(object, sizeof(T), alignof(T));
+        }
+
+        static constexpr Ops ops{typeid(T), &copy, &destroy};
+    };
+
+public:
+    using allocator_type = RegistryAllocatorT;
+
+    template<typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, RegistryTrait>>>
+    explicit RegistryTrait(T&& value, const allocator_type& allocator = {})
+        : mOps(&OpsHolder<std::decay_t<T>>::ops)
+        , mResource(allocator.resource())
+        , mObject(OpsHolder<std::decay_t<T>>::create(std::forward<T>(value), mResource))
+    {}
+
+    RegistryTrait(const RegistryTrait& other, const allocator_type& allocator = {})
+        : mOps(other.mOps)
+        , mResource(allocator.resource())
+        , mObject(other.mOps->copy(other.mObject, mResource))
+    {}
+
+    RegistryTrait(RegistryTrait&& other) noexcept
+        : mOps(other.mOps)
+        , mResource(other.mResource)
+        , mObject(std::exchange(other.mObject, nullptr))
+    {}
+
+    RegistryTrait(RegistryTrait&& other, const allocator_type& allocator)
+        : mOps(other.mOps)
+        , mResource(allocator.resource())
+        , mObject(*mResource == *other.mResource ? std::exchange(other.mObject, nullptr)
+                                                   : other.mOps->copy(other.mObject, mResource))
+    {}
+
+    RegistryTrait& operator=(const RegistryTrait& other)
+    {
+        if (this != &other)
+        {
+            *this = RegistryTrait(other, mResource);
+        }
+        return *this;
+    }
+
+    RegistryTrait& operator=(RegistryTrait&& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+        if (*mResource != *other.mResource)
+        {
+            return *this = RegistryTrait(std::move(other), mResource);
+        }
+        reset();
+        mOps = other.mOps;
+        mObject = std::exchange(other.mObject, nullptr);
+        return *this;
+    }
+
+    ~RegistryTrait()
+    {
+        reset();
+    }
+
+    /**
+     * @returns stored value if it has type T, nullptr otherwise
+     */
+    template<typename T>
+    [[ nodiscard ]] const T* get() const noexcept
+    {
+        // types are compared by ops address first, type_info is the fallback for ops duplicated across modules
+        if (mObject != nullptr && (mOps == &OpsHolder<T>::ops || mOps->type == typeid(T)))
+        {
+            return static_cast<const T*>(mObject);
+        }
+        return nullptr;
+    }
+
+private:
+    void reset() noexcept
+    {
+        if (mObject != nullptr)
+        {
+            mOps->destroy(mObject, mResource);
+            mObject = nullptr;
+        }
+    }
+
+private:
+    const Ops* mOps;
+    std::pmr::memory_resource* mResource;
+    void* mObject;
+};
+
+/**
+ * @details every registry takes an allocator and can be copied into memory of another resource,
+ * keys of types which allocate with std::allocator (e.g. long std::string) still allocate on the general heap
+ */
+template<typename KeyT, typename ValueT>
+class HashRegistry final
+{
+public:
+    using allocator_type = RegistryAllocatorT;
+
+    HashRegistry() = default;
+
+    explicit HashRegistry(const allocator_type& allocator)
+        : mMap(allocator)
+    {}
+
+    HashRegistry(const HashRegistry& other, const allocator_type& allocator)
+        : mMap(other.mMap, allocator)
+    {}
+
+    [[ nodiscard ]] allocator_type get_allocator() const noexcept { return mMap.get_allocator(); }
+
+    [[ nodiscard ]] bool contains(const KeyT& key) const
+    {
+        return mMap.find(key) != mMap.end();
+    }
+
+    void emplace(const KeyT& key, ValueT value)
+    {
+        mMap.emplace(key, std::move(value));
+    }
+
+    /**
+     * @details calls visitor for every value registred with key until it returns true,
+     * a key of other type than KeyT is converted to KeyT since C++17 has no heterogeneous lookup
+     */
+    template<typename LookupT, typename VisitorT>
+    void visit(const LookupT& key, VisitorT&& visitor) const
+    {
+        if constexpr (!std::is_same_v<LookupT, KeyT>)
+        {
+            visit(KeyT(key), std::forward<VisitorT>(visitor));
+        }
+        else
+        {
+            const auto range = mMap.equal_range(key);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (visitor(it->second))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    [[ nodiscard ]] std::size_t size() const noexcept { return mMap.size(); }
+
+private:
+    std::pmr::unordered_multimap<KeyT, ValueT> mMap;
+};
+
+template<typename KeyT, typename ValueT>
+class SmallRegistry final
+{
+public:
+    using allocator_type = RegistryAllocatorT;
+
+    SmallRegistry() = default;
+
+    explicit SmallRegistry(const allocator_type& allocator)
+        : mDigests(allocator)
+        , mKeys(allocator)
+        , mValues(allocator)
+    {}
+
+    SmallRegistry(const SmallRegistry& other, const allocator_type& allocator)
+        : mDigests(other.mDigests, allocator)
+        , mKeys(other.mKeys, allocator)
+        , mValues(other.mValues, allocator)
+    {}
+
+    [[ nodiscard ]] allocator_type get_allocator() const noexcept { return mValues.get_allocator(); }
+
+    [[ nodiscard ]] bool contains(const KeyT& key) const
+    {
+        return next(key, RegistryKeyDigest<KeyT>::get(key), 0) != mKeys.size();
+    }
+
+    void emplace(const KeyT& key, ValueT value)
+    {
+        mDigests.push_back(RegistryKeyDigest<KeyT>::get(key));
+        try
+        {
+            mKeys.push_back(key);
+            try
+            {
+                mValues.push_back(std::move(value));
+            } catch (...)
+            {
+                mKeys.pop_back();
+                throw;
+            }
+        } catch (...)
+        {
+            mDigests.pop_back();
+            throw;
+        }
+    }
+
+    /**
+     * @details calls visitor for every value registred with key until it returns true,
+     * LookupT must be comparable with KeyT and have the same digest for equal keys, e.g. std::string_view
+     */
+    template<typename LookupT, typename VisitorT>
+    void visit(const LookupT& key, VisitorT&& visitor) const
+    {
+        const auto digest = RegistryKeyDigest<LookupT>::get(key);
+        for (auto i = next(key, digest, 0); i != mKeys.size(); i = next(key, digest, i + 1))
+        {
+            if (visitor(mValues[i]))
+            {
+                return;
+            }
+        }
+    }
+
+    [[ nodiscard ]] std::size_t size() const noexcept { return mKeys.size(); }
+
+    template<typename RegistryT>
+    void copyTo(RegistryT& registry) const
+    {
+        for (std::size_t i = 0; i < mKeys.size(); ++i)
+        {
+            registry.emplace(mKeys[i], mValues[i]);
+        }
+    }
+
+private:
+    template<typename LookupT>
+    std::size_t next(const LookupT& key, std::uint64_t digest, std::size_t from) const
+    {
+        const auto count = mDigests.size();
+        for (auto i = findRegistryDigest(mDigests.data(), count, digest, from); i != count;
+             i = findRegistryDigest(mDigests.data(), count, digest, i + 1))
+        {
+            if (mKeys[i] == key)
+            {
+                return i;
+            }
+        }
+        return count;
+    }
+
+private:
+    std::pmr::vector<std::uint64_t> mDigests;
+    std::pmr::vector<KeyT> mKeys;
+    std::pmr::vector<ValueT> mValues;
+};
+
+template<typename KeyT, typename ValueT, std::size_t SmallLimit>
+class AutoRegistry final
+{
+public:
+    using allocator_type = RegistryAllocatorT;
+
+    AutoRegistry() = default;
+
+    explicit AutoRegistry(const allocator_type& allocator)
+        : mSmall(allocator)
+        , mHash(allocator)
+    {}
+
+    AutoRegistry(const AutoRegistry& other, const allocator_type& allocator)
+        : mSmall(other.mSmall, allocator)
+        , mHash(other.mHash, allocator)
+        , mKeyCount(other.mKeyCount)
+        , mHashed(other.mHashed)
+    {}
+
+    [[ nodiscard ]] allocator_type get_allocator() const noexcept { return mHash.get_allocator(); }
+
+    [[ nodiscard ]] bool contains(const KeyT& key) const
+    {
+        return mHashed ? mHash.contains(key) : mSmall.contains(key);
+    }
+
+    void emplace(const KeyT& key, ValueT value)
+    {
+        // the limit counts distinct keys, a key may hold several entries (one per creation signature)
+        const bool newKey = !contains(key);
+        if (newKey && !mHashed && mKeyCount >= SmallLimit)
+        {
+            // the small registry stays intact until every entry is in the hash one
+            HashRegistry<KeyT, ValueT> hash(get_allocator());
+            mSmall.copyTo(hash);
+            mHash = std::move(hash);
+            mSmall = SmallRegistry<KeyT, ValueT>(get_allocator());
+            mHashed = true;
+        }
+        if (mHashed)
+        {
+            mHash.emplace(key, std::move(value));
+        }
+        else
+        {
+            mSmall.emplace(key, std::move(value));
+        }
+        if (newKey)
+        {
+            ++mKeyCount;
+        }
+    }
+
+    template<typename LookupT, typename VisitorT>
+    void visit(const LookupT& key, VisitorT&& visitor) const
+    {
+        if (mHashed)
+        {
+            mHash.visit(key, std::forward<VisitorT>(visitor));
+        }
+        else
+        {
+            mSmall.visit(key, std::forward<VisitorT>(visitor));
+        }
+    }
+
+    [[ nodiscard ]] std::size_t size() const noexcept { return mHashed ? mHash.size() : mSmall.size(); }
+
+private:
+    SmallRegistry<KeyT, ValueT> mSmall;
+    HashRegistry<KeyT, ValueT> mHash;
+    std::size_t mKeyCount{0};
+    bool mHashed{false};
+};
+
+template<typename PolicyT, typename KeyT, typename ValueT>
+struct RegistrySelector;
+
+template<typename KeyT, typename ValueT>
+struct RegistrySelector<pattern::registry_policy::Hash, KeyT, ValueT>
+{
+    using type = HashRegistry<KeyT, ValueT>;
+};
+
+template<typename KeyT, typename ValueT>
+struct RegistrySelector<pattern::registry_policy::Small, KeyT, ValueT>
+{
+    using type = SmallRegistry<KeyT, ValueT>;
+};
+
+template<std::size_t SmallLimit, typename KeyT, typename ValueT>
+struct RegistrySelector<pattern::registry_policy::Auto<SmallLimit>, KeyT, ValueT>
+{
+    using type = AutoRegistry<KeyT, ValueT, SmallLimit>;
+};
+
+template<typename BaseT, typename KeyT, typename ValueT>
+using FactoryRegistryT = typename RegistrySelector<typename pattern::FactoryRegistryPolicy<BaseT, KeyT>::type,
+                                                   KeyT, ValueT>::type;
+
+} // namespace impl_pattern
+
+#undef IMPL_PATTERN_REGISTRY_AVX2
+#undef IMPL_PATTERN_REGISTRY_SSE2
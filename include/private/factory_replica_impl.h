@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace impl_pattern
+{
+
+constexpr std::size_t kNoReplicaGroup = std::numeric_limits<std::size_t>::max();
+
+/**
+ * @brief replica group the current thread is bound to explicitly, kNoReplicaGroup if none
+ */
+inline std::size_t& currentReplicaGroupOverride() noexcept
+{
+    thread_local std::size_t group = kNoReplicaGroup;
+    return group;
+}
+
+/**
+ * @returns cpu the current thread runs on or -1 if it is unknown
+ */
+inline int currentCpu() noexcept
+{
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @details parses linux cpu list format, e.g. "0-3,8,10-11"
+ */
+inline std::vector<int> parseCpuList(const std::string& cpuList)
+{
+    std::vector<int> cpus;
+    std::stringstream stream(cpuList);
+    std::string range;
+    while (std::getline(stream, range, ','))
+    {
+        if (range.empty() || range == "\n")
+        {
+            continue;
+        }
+        const auto dash = range.find('-');
+        const auto first = std::stoi(range.substr(0, dash));
+        const auto last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (auto cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @returns cpus of every online numa node, empty if the topology is unavailable
+ */
+inline std::vector<std::vector<int>> readNumaNodeCpus()
+{
+    std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+    try
+    {
+        std::ifstream onlineFile("/sys/devices/system/node/online");
+        std::string online;
+        if (!std::getline(onlineFile, online))
+        {
+            return nodes;
+        }
+        for (const auto node : parseCpuList(online))
+        {
+            std::ifstream cpuListFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            std::string cpuList;
+            std::getline(cpuListFile, cpuList);
+            auto cpus = parseCpuList(cpuList);
+            if (!cpus.empty())
+            {
+                nodes.push_back(std::move(cpus));
+            }
+        }
+    } catch (const std::exception&)
+    {
+        nodes.clear();
+    }
+#endif
+    return nodes;
+}
+
+/**
+ * @details runs function in a new thread pinned to cpus, memory it first writes is placed on their numa node
+ * only if no other thread touched its page before, @sa ReplicaArena. function runs even if the thread can't be pinned.
+ * @returns true if the thread was pinned, false if cpus is empty, pinning is not supported or it failed,
+ * e.g. because the cpus are outside of the process cpuset
+ * @throws whatever function throws
+ */
+template<typename FunctionT>
+bool runPinnedToCpus(const std::vector<int>& cpus, FunctionT&& function)
+{
+    std::exception_ptr error;
+    bool pinned = false;
+    std::thread thread([&cpus, &function, &error, &pinned]
+    {
+#if defined(__linux__)
+        if (!cpus.empty())
+        {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            for (const auto cpu : cpus)
+            {
+                CPU_SET(cpu, &cpuSet);
+            }
+            pinned = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+        }
+#endif
+        try
+        {
+            function();
+        } catch (...)
+        {
+            error = std::current_exception();
+        }
+    });
+    thread.join();
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    return pinned;
+}
+
+/**
+ * @brief memory resource which maps fresh pages for every allocation and shares them with nothing else
+ * @details a page gets its numa node when it is first written, so the thread writing it decides the placement
+ */
+class ReplicaPageResource final : public std::pmr::memory_resource
+{
+public:
+    static std::size_t pageSize() noexcept
+    {
+#if defined(__linux__)
+        const auto size = sysconf(_SC_PAGESIZE);
+        return size > 0 ? static_cast<std::size_t>(size) : 4096;
+#else
+        return 4096;
+#endif
+    }
+
+private:
+    static std::size_t roundToPages(std::size_t bytes) noexcept
+    {
+        const auto page = pageSize();
+        return (bytes + page - 1) / page * page;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > pageSize())
+        {
+            throw std::bad_alloc();
+        }
+#if defined(__linux__)
+        void* pages = mmap(nullptr, roundToPages(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pages == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        return pages;
+#else
+        return ::operator new(roundToPages(bytes), std::align_val_t(pageSize()));
+#endif
+    }
+
+    void do_deallocate(void* pages, std::size_t bytes, std::size_t) override
+    {
+#if defined(__linux__)
+        munmap(pages, roundToPages(bytes));
+#else
+        ::operator delete(pages, roundToPages(bytes), std::align_val_t(pageSize()));
+#endif
+    }
+
+    [[ nodiscard ]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/**
+ * @brief memory of a single replica: its own pages carved sequentially since a replica is never modified
+ * @details the pages are written first by the thread which builds the replica, so they land on its numa node
+ */
+class ReplicaArena final
+{
+public:
+    ReplicaArena()
+        : mArena(ReplicaPageResource::pageSize(), &mPages)
+    {}
+
+    ReplicaArena(const ReplicaArena&) = delete;
+    ReplicaArena& operator=(const ReplicaArena&) = delete;
+    ReplicaArena(ReplicaArena&&) = delete;
+    ReplicaArena& operator=(ReplicaArena&&) = delete;
+
+    [[ nodiscard ]] std::pmr::memory_resource* resource() noexcept { return &mArena; }
+
+private:
+    ReplicaPageResource mPages;
+    std::pmr::monotonic_buffer_resource mArena;
+};
+
+} // namespace impl_pattern
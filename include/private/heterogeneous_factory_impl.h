@@ -1,10 +1,11 @@
 #pragma once
 
 #include "traits.h"
+#include "poly_value_impl.h"
+#include "factory_registry_impl.h"
+#include "factory_record_impl.h"
 #include <memory>
-#include <map>
 #include <functional>
-#include <any>
 #include <cassert>
 
 namespace pattern
@@ -27,28 +28,109 @@ class ImplHGSFactory final
 protected:
     using BasePtrT = std::unique_ptr<BaseT>;
     using DefaultCreatorTraitT = std::function<BasePtrT(DefaultCreationArgsT...)>;
+    using ValueSlotT = PolyValueSlot<BaseT>;
+    template<typename... Args>
+    using ValueCreatorTraitT = std::function<ValueSlotT(void*, std::size_t, Args...)>;
+    using RecordCreatorTraitT = std::function<BasePtrT(pattern::RecordReader&)>;
 
 private:
     template<typename... Args>
     [[ nodiscard ]] BasePtrT create(KeyT factoryRegistrationKey, Args... args) const noexcept
     {
         using CreatorTraitT = std::function<BasePtrT(Args...)>;
+        BasePtrT object;
         try
         {
-            const auto range = mTraitsMap.equal_range(factoryRegistrationKey);
-            for (auto it = range.first; it != range.second; ++it)
+            mTraitsMap.visit(factoryRegistrationKey, [&](const RegistryTrait& trait)
             {
-                try
+                if (const auto* creator = trait.get<CreatorTraitT>())
                 {
-                    const auto creator = std::any_cast<CreatorTraitT>(it->second);
-                    return creator(std::forward<Args>(args)...);
+                    object = (*creator)(std::forward<Args>(args)...);
+                    return true;
                 }
-                catch (const std::bad_any_cast&) {}
-            }
+                return false;
+            });
+        } catch (const std::exception&) {}
+        return object;
+    }
+
+    template<std::size_t InlineSize, typename... Args>
+    [[ nodiscard ]] pattern::PolyValue<BaseT, InlineSize> createValue(KeyT factoryRegistrationKey,
+                                                                      Args... args) const noexcept
+    {
+        using CreatorTraitT = ValueCreatorTraitT<Args...>;
+        pattern::PolyValue<BaseT, InlineSize> value;
+        try
+        {
+            mValueTraitsMap.visit(factoryRegistrationKey, [&](const RegistryTrait& trait)
+            {
+                if (const auto* creator = trait.get<CreatorTraitT>())
+                {
+                    const auto slot = (*creator)(PolyValueAccess::storage(value), InlineSize,
+                                                 std::forward<Args>(args)...);
+                    PolyValueAccess::assign(value, slot);
+                    return true;
+                }
+                return false;
+            });
+        } catch (const std::exception&) {}
+        return value;
+    }
+
+    [[ nodiscard ]] BasePtrT createFromRecord(pattern::RecordView record) const noexcept
+    {
+        try
+        {
+            pattern::RecordReader reader(record);
+            const auto body = reader.takeRecord();
+            return reader.empty() ? createFromRecordBody(body) : nullptr;
         } catch (const std::exception&) {}
         return nullptr;
     }
 
+    template<typename SinkT>
+    std::size_t createAll(pattern::RecordView buffer, SinkT&& sink) const
+    {
+        std::size_t count = 0;
+        pattern::RecordReader reader(buffer);
+        while (!reader.empty())
+        {
+            pattern::RecordView body;
+            try
+            {
+                body = reader.takeRecord();
+            } catch (const std::out_of_range&)
+            {
+                break;
+            }
+            sink(createFromRecordBody(body));
+            ++count;
+        }
+        return count;
+    }
+
+    [[ nodiscard ]] BasePtrT createFromRecordBody(pattern::RecordView body) const noexcept
+    {
+        BasePtrT object;
+        try
+        {
+            pattern::RecordReader reader(body);
+            // string keys are looked up through a view into the record, the hash registry still copies them
+            using RecordKeyT = std::conditional_t<std::is_same_v<KeyT, std::string>, std::string_view, KeyT>;
+            const auto factoryRegistrationKey = pattern::RecordCodec<RecordKeyT>::decode(reader);
+            mRecordTraitsMap.visit(factoryRegistrationKey, [&](const RecordCreatorTraitT& creator)
+            {
+                object = creator(reader);
+                return true;
+            });
+            if (!reader.empty())
+            {
+                object.reset();
+            }
+        } catch (const std::exception&) {}
+        return object;
+    }
+
     template<class RegistredT, typename... Args>
     void registerType(KeyT factoryRegistrationKey) noexcept
     {
@@ -60,7 +142,7 @@ private:
         using CreatorTraitT = std::function<BasePtrT(Args...)>;
         try
         {
-            if (const auto it = mTraitsMap.find(factoryRegistrationKey); it != mTraitsMap.end())
+            if (mTraitsMap.contains(factoryRegistrationKey))
             {
                 assert(((void)"You have the same registration key for several types "
                               "or you are trying to register the same type twice", false));
@@ -72,7 +154,14 @@ private:
                 {
                     return std::make_unique<RegistredT>(std::forward<DefaultCreationArgsT>(args)...);
                 };
-                mTraitsMap.emplace(factoryRegistrationKey, defaultTrait);
+                mTraitsMap.emplace(factoryRegistrationKey, RegistryTrait(defaultTrait));
+                const ValueCreatorTraitT<DefaultCreationArgsT...> defaultValueTrait =
+                    [](void* storage, std::size_t capacity, DefaultCreationArgsT... args)
+                {
+                    return emplacePolyValue<BaseT, RegistredT>(storage, capacity,
+                                                               std::forward<DefaultCreationArgsT>(args)...);
+                };
+                mValueTraitsMap.emplace(factoryRegistrationKey, RegistryTrait(defaultValueTrait));
             }
             if constexpr (!std::is_same_v<CreatorTraitT, DefaultCreatorTraitT>
                           && std::is_constructible_v<RegistredT, Args...>)
@@ -81,11 +170,43 @@ private:
                 {
                     return std::make_unique<RegistredT>(std::forward<Args>(args)...);
                 };
-                mTraitsMap.emplace(factoryRegistrationKey, trait);
+                mTraitsMap.emplace(factoryRegistrationKey, RegistryTrait(trait));
+                const ValueCreatorTraitT<Args...> valueTrait = [](void* storage, std::size_t capacity, Args... args)
+                {
+                    return emplacePolyValue<BaseT, RegistredT>(storage, capacity, std::forward<Args>(args)...);
+                };
+                mValueTraitsMap.emplace(factoryRegistrationKey, RegistryTrait(valueTrait));
+            }
+            if constexpr (!std::is_same_v<CreatorTraitT, DefaultCreatorTraitT>
+                          && std::is_constructible_v<RegistredT, Args...>)
+            {
+                registerRecordCreator<RegistredT, Args...>(factoryRegistrationKey);
+            }
+            else if constexpr (std::is_constructible_v<RegistredT, DefaultCreationArgsT...>)
+            {
+                registerRecordCreator<RegistredT, DefaultCreationArgsT...>(factoryRegistrationKey);
             }
         } catch (const std::exception&) {}
     }
 
+    /**
+     * @details records decoder of Args from packed records if all of them have RecordCodec
+     * and RegistredT is constructible from decoded rvalues (e.g. not from 'int&'),
+     * only one signature per key can be created from records
+     */
+    template<class RegistredT, typename... Args>
+    void registerRecordCreator(const KeyT& factoryRegistrationKey)
+    {
+        if constexpr (traits::is_record_decodable<KeyT>::value && traits::are_record_decodable_v<Args...>
+                      && std::is_constructible_v<RegistredT, std::decay_t<Args>&&...>)
+        {
+            mRecordTraitsMap.emplace(factoryRegistrationKey, [](pattern::RecordReader& reader)
+            {
+                return makeFromRecord<BaseT, RegistredT, Args...>(reader);
+            });
+        }
+    }
+
     template<class RegistredT, typename... Args>
     void registerType() noexcept
     {
@@ -101,9 +222,21 @@ private:
     ImplHGSFactory(ImplHGSFactory&&) = default;
     ImplHGSFactory& operator=(ImplHGSFactory&&) = default;
 
+    /**
+     * @details copies every registry with its entries into memory of allocator resource,
+     * creators registred here capture nothing, so std::function keeps them inline
+     */
+    ImplHGSFactory(const ImplHGSFactory& other, const RegistryAllocatorT& allocator)
+        : mTraitsMap(other.mTraitsMap, allocator)
+        , mValueTraitsMap(other.mValueTraitsMap, allocator)
+        , mRecordTraitsMap(other.mRecordTraitsMap, allocator)
+    {}
+
 private:
-    using TraitsMap = std::unordered_multimap<KeyT, std::any>;
+    using TraitsMap = FactoryRegistryT<BaseT, KeyT, RegistryTrait>;
     TraitsMap mTraitsMap;
+    TraitsMap mValueTraitsMap;
+    FactoryRegistryT<BaseT, KeyT, RecordCreatorTraitT> mRecordTraitsMap;
 
 private:
     template<typename TForward, typename KeyTForward, typename... ArgsForward>
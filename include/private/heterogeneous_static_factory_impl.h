@@ -1,6 +1,7 @@
 #pragma once
 
 #include "heterogeneous_factory_impl.h"
+#include "../factory_replica_topology.h"
 
 namespace pattern
 {
@@ -11,6 +12,12 @@ class StaticHGSFactory;
 namespace impl_pattern
 {
 
+/**
+ * @brief grants tests access to StaticHGSFactoryImpl internals, defined by tests only
+ */
+template<typename StaticFactoryImplT>
+struct StaticHGSFactoryImplTestAccess;
+
 template<typename BaseT, typename KeyT, typename... DefaultCreationArgsT>
 class StaticHGSFactoryImpl final
 {
@@ -21,15 +28,63 @@ private:
     template<typename... CreationArgsT>
     static BasePtrT create(const KeyT& factoryRegistrationKey, CreationArgsT... args) noexcept
     {
-        return getFactory().create(factoryRegistrationKey, std::forward<CreationArgsT>(args)...);
+        return getReadFactory().create(factoryRegistrationKey, std::forward<CreationArgsT>(args)...);
+    }
+
+    template<std::size_t InlineSize, typename... CreationArgsT>
+    static pattern::PolyValue<BaseT, InlineSize> createValue(const KeyT& factoryRegistrationKey,
+                                                             CreationArgsT... args) noexcept
+    {
+        return getReadFactory().template createValue<InlineSize>(factoryRegistrationKey,
+                                                                 std::forward<CreationArgsT>(args)...);
+    }
+
+    static BasePtrT createFromRecord(pattern::RecordView record) noexcept
+    {
+        return getReadFactory().createFromRecord(record);
+    }
+
+    template<typename SinkT>
+    static std::size_t createAll(pattern::RecordView buffer, SinkT&& sink)
+    {
+        return getReadFactory().createAll(buffer, std::forward<SinkT>(sink));
     }
 
     template<class T, typename... RegisterArgsT>
     static void registerType() noexcept
     {
+        assert(((void)"Types must be registred before the factory is replicated", getReplicas().factories.empty()));
         getFactory().template registerType<T, RegisterArgsT...>();
     }
 
+    static bool replicate(const pattern::ReplicaTopology& topology) noexcept
+    {
+        try
+        {
+            bool pinned = true;
+            std::vector<std::unique_ptr<Replica>> factories;
+            factories.reserve(topology.groupCount());
+            for (std::size_t group = 0; group < topology.groupCount(); ++group)
+            {
+                // the arena pages are mapped and first written by the pinned thread
+                pinned = runPinnedToCpus(topology.cpus(group), [&factories]
+                {
+                    factories.push_back(std::make_unique<Replica>(getFactory()));
+                }) && pinned;
+            }
+            auto& replicas = getReplicas();
+            replicas.topology = topology;
+            replicas.factories = std::move(factories);
+            return pinned;
+        } catch (const std::exception&) {}
+        return false;
+    }
+
+    static std::size_t replicaCount() noexcept
+    {
+        return getReplicas().factories.size();
+    }
+
 public:
     StaticHGSFactoryImpl() = delete;
     StaticHGSFactoryImpl(const StaticHGSFactoryImpl&) = delete;
@@ -38,15 +93,67 @@ public:
     StaticHGSFactoryImpl& operator=(StaticHGSFactoryImpl&&) = delete;
 
 private:
+    /**
+     * @brief copy of the registry placed with all its entries in pages of its own arena
+     */
+    class Replica final
+    {
+    public:
+        explicit Replica(const FactoryT& factory)
+            : mFactory(::new (mArena.resource()->allocate(sizeof(FactoryT), alignof(FactoryT)))
+                       FactoryT(factory, RegistryAllocatorT(mArena.resource())))
+        {}
+
+        ~Replica()
+        {
+            mFactory->~FactoryT();
+        }
+
+        Replica(const Replica&) = delete;
+        Replica& operator=(const Replica&) = delete;
+        Replica(Replica&&) = delete;
+        Replica& operator=(Replica&&) = delete;
+
+        [[ nodiscard ]] const FactoryT& factory() const noexcept { return *mFactory; }
+
+    private:
+        ReplicaArena mArena;
+        FactoryT* mFactory;
+    };
+
+    struct Replicas
+    {
+        pattern::ReplicaTopology topology;
+        std::vector<std::unique_ptr<Replica>> factories;
+    };
+
     static FactoryT& getFactory()
     {
         static FactoryT factory;
         return factory;
     }
 
+    static Replicas& getReplicas()
+    {
+        static Replicas replicas;
+        return replicas;
+    }
+
+    static const FactoryT& getReadFactory() noexcept
+    {
+        const auto& replicas = getReplicas();
+        if (replicas.factories.empty())
+        {
+            return getFactory();
+        }
+        return replicas.factories[replicas.topology.currentGroup()]->factory();
+    }
+
 private:
     template<typename TForward, typename KeyTForward, typename... ArgsForward>
     friend class pattern::StaticHGSFactory;
+    template<typename StaticFactoryImplT>
+    friend struct StaticHGSFactoryImplTestAccess;
 };
 
 } // namespace impl_pattern
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pattern
+{
+template<typename TForward, std::size_t InlineSizeForward>
+class PolyValue;
+} // namespace pattern
+
+namespace impl_pattern
+{
+
+/**
+ * @brief per-type hooks recorded at registration time to manage an object stored inline in PolyValue
+ * @details relocate move-constructs the object into 'to', destroys the source and returns the new base pointer.
+ * Whether an object fits the inline storage is decided at compile time by emplacePolyValue.
+ */
+template<typename BaseT>
+struct PolyValueTypeOps
+{
+    BaseT* (*relocate)(void* from, void* to) noexcept;
+    void (*destroy)(void* object) noexcept;
+};
+
+/**
+ * @brief result of a value creator: constructed object and its inline ops, ops is nullptr for heap objects
+ */
+template<typename BaseT>
+struct PolyValueSlot
+{
+    BaseT* object{nullptr};
+    const PolyValueTypeOps<BaseT>* ops{nullptr};
+};
+
+constexpr std::size_t kPolyValueAlignment = alignof(std::max_align_t);
+
+template<class T>
+constexpr bool is_poly_value_inlineable_v = std::is_nothrow_move_constructible_v<T>
+                                            && alignof(T) <= kPolyValueAlignment;
+
+template<typename BaseT, class RegistredT>
+struct PolyValueTypeOpsHolder
+{
+    static BaseT* relocate(void* from, void* to) noexcept
+    {
+        auto* source = static_cast<RegistredT*>(from);
+        auto* target = ::new (to) RegistredT(std::move(*source));
+        source->~RegistredT();
+        return target;
+    }
+
+    static void destroy(void* object) noexcept
+    {
+        static_cast<RegistredT*>(object)->~RegistredT();
+    }
+
+    static constexpr PolyValueTypeOps<BaseT> ops{&relocate, &destroy};
+};
+
+/**
+ * @details constructs RegistredT inside storage if it fits, on the heap otherwise
+ * @throws whatever RegistredT constructor or operator new throws
+ */
+template<typename BaseT, class RegistredT, typename... Args>
+PolyValueSlot<BaseT> emplacePolyValue(void* storage, std::size_t capacity, Args&&... args)
+{
+    if constexpr (is_poly_value_inlineable_v<RegistredT>)
+    {
+        if (sizeof(RegistredT) <= capacity)
+        {
+            return {::new (storage) RegistredT(std::forward<Args>(args)...),
+                    &PolyValueTypeOpsHolder<BaseT, RegistredT>::ops};
+        }
+    }
+    return {new RegistredT(std::forward<Args>(args)...), nullptr};
+}
+
+/**
+ * @brief grants factories access to PolyValue internals without exposing them to users
+ */
+struct PolyValueAccess
+{
+    template<typename BaseT, std::size_t InlineSize>
+    static void* storage(pattern::PolyValue<BaseT, InlineSize>& value) noexcept
+    {
+        return value.mStorage;
+    }
+
+    template<typename BaseT, std::size_t InlineSize>
+    static void assign(pattern::PolyValue<BaseT, InlineSize>& value, PolyValueSlot<BaseT> slot) noexcept
+    {
+        value.mObject = slot.object;
+        value.mOps = slot.ops;
+    }
+};
+
+} // namespace impl_pattern
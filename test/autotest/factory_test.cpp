@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <set>
+#include <thread>
 #include "heterogeneous_factory.h"
 #include "heterogeneous_static_factory.h"
 #include "factory_static_registrator.h"
@@ -149,6 +151,329 @@ TEST(FactoryTest, SharedLibraryRegistrationTest)
     EXPECT_THAT(secondTestObject, NotNull());
 }
 
+TEST(FactoryTest, PolyValueCreationTest)
+{
+    InterfaceIntInternalRegistredFactory factory;
+    factory.registerTypes();
+    auto concrete = factory.createValue<32>(ConcreteInt::factoryRegistrationKey(), 20);
+    ASSERT_TRUE(concrete);
+    EXPECT_TRUE(concrete.isInline());
+    EXPECT_THAT(concrete->getVal(), Eq(20));
+    auto heapConcrete = factory.createValue<1>(ConcreteInt::factoryRegistrationKey(), 30);
+    ASSERT_TRUE(heapConcrete);
+    EXPECT_FALSE(heapConcrete.isInline());
+    EXPECT_THAT(heapConcrete->getVal(), Eq(30));
+    auto missing = factory.createValue<32>(ConcreteInt::factoryRegistrationKey(), 1, 2, 3);
+    EXPECT_FALSE(missing);
+
+    auto movedConcrete = std::move(concrete);
+    EXPECT_FALSE(concrete);
+    ASSERT_TRUE(movedConcrete);
+    EXPECT_TRUE(movedConcrete.isInline());
+    EXPECT_THAT(movedConcrete->getVal(), Eq(20));
+    auto movedHeapConcrete = std::move(heapConcrete);
+    EXPECT_FALSE(heapConcrete);
+    ASSERT_TRUE(movedHeapConcrete);
+    EXPECT_FALSE(movedHeapConcrete.isInline());
+    EXPECT_THAT(movedHeapConcrete->getVal(), Eq(30));
+    movedConcrete = factory.createValue<32>(1, 7);
+    EXPECT_FALSE(movedConcrete);
+    movedConcrete = factory.createValue<32>(1, 7, 1);
+    ASSERT_TRUE(movedConcrete);
+    EXPECT_THAT(movedConcrete->getVal(), Eq(7));
+    movedConcrete.reset();
+    EXPECT_FALSE(movedConcrete);
+
+    auto staticConcrete = InterfaceStringFactory::createValue<32>(ConcreteString::factoryRegistrationKey());
+    ASSERT_TRUE(staticConcrete);
+    EXPECT_TRUE(staticConcrete.isInline());
+    EXPECT_THAT(staticConcrete->getVal(), Eq(43));
+    auto staticSecondConcrete = InterfaceStringFactory::createValue<32>(SecondConcreteString::factoryRegistrationKey(), 5, 1);
+    ASSERT_TRUE(staticSecondConcrete);
+    EXPECT_THAT(staticSecondConcrete->getVal(), Eq(5));
+}
+
+struct InterfaceSmallRegistry
+{
+    virtual ~InterfaceSmallRegistry() = default;
+    virtual int getVal() const noexcept = 0;
+};
+
+struct InterfaceAutoRegistry
+{
+    virtual ~InterfaceAutoRegistry() = default;
+    virtual int getVal() const noexcept = 0;
+};
+
+template<>
+struct pattern::FactoryRegistryPolicy<InterfaceSmallRegistry, std::string>
+{
+    using type = registry_policy::Small;
+};
+
+template<>
+struct pattern::FactoryRegistryPolicy<InterfaceAutoRegistry, int>
+{
+    using type = registry_policy::Auto<4>;
+};
+
+template<typename BaseT>
+struct ConcreteRegistry : BaseT
+{
+    ConcreteRegistry(int val) : m_Val(val) {}
+    ConcreteRegistry(int a, int b) : m_Val(a + b) {}
+    int getVal() const noexcept override { return m_Val; }
+
+private:
+    int m_Val{0};
+};
+
+struct SecondConcreteRegistry : ConcreteRegistry<InterfaceSmallRegistry>
+{
+    using ConcreteRegistry::ConcreteRegistry;
+};
+
+struct ThirdConcreteRegistry : ConcreteRegistry<InterfaceSmallRegistry>
+{
+    using ConcreteRegistry::ConcreteRegistry;
+};
+
+TEST(FactoryTest, SmallRegistryTest)
+{
+    HGSFactory<InterfaceSmallRegistry, std::string, int> factory;
+    const std::vector<std::string> keys{"a", "ab", "abcdefg", "abcdefgh", "abcdefgi", "b", ""};
+    for (const auto& key : keys)
+    {
+        factory.registerType<ConcreteRegistry<InterfaceSmallRegistry>, int, int>(key);
+    }
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        auto concrete = factory.create(keys[i], static_cast<int>(i));
+        ASSERT_THAT(concrete, NotNull());
+        EXPECT_THAT(concrete->getVal(), Eq(static_cast<int>(i)));
+        concrete = factory.create(keys[i], static_cast<int>(i), 1);
+        ASSERT_THAT(concrete, NotNull());
+        EXPECT_THAT(concrete->getVal(), Eq(static_cast<int>(i) + 1));
+    }
+    EXPECT_THAT(factory.create("abcdefgj", 1), IsNull());
+    EXPECT_THAT(factory.create("c", 1), IsNull());
+
+    // same length, first 3 and last 4 characters give the same digest, full keys must be compared
+    factory.registerType<SecondConcreteRegistry, int, int>("abcXdefg");
+    factory.registerType<ThirdConcreteRegistry, int, int>("abcYdefg");
+    auto second = factory.create("abcXdefg", 1);
+    auto third = factory.create("abcYdefg", 1);
+    EXPECT_THAT(dynamic_cast<SecondConcreteRegistry*>(second.get()), NotNull());
+    EXPECT_THAT(dynamic_cast<ThirdConcreteRegistry*>(third.get()), NotNull());
+    EXPECT_THAT(factory.create("abcZdefg", 1), IsNull());
+}
+
+TEST(FactoryTest, AutoRegistryTest)
+{
+    // every key holds two creators, so the registry switches on keys, not on entries
+    HGSFactory<InterfaceAutoRegistry, int, int> factory;
+    for (int key = 0; key < 10; ++key)
+    {
+        factory.registerType<ConcreteRegistry<InterfaceAutoRegistry>, int, int>(key);
+        for (int registred = 0; registred <= key; ++registred)
+        {
+            auto concrete = factory.create(registred, registred * 2);
+            ASSERT_THAT(concrete, NotNull());
+            EXPECT_THAT(concrete->getVal(), Eq(registred * 2));
+            concrete = factory.create(registred, registred, 1);
+            ASSERT_THAT(concrete, NotNull());
+            EXPECT_THAT(concrete->getVal(), Eq(registred + 1));
+        }
+        EXPECT_THAT(factory.create(key + 1, 1), IsNull());
+    }
+}
+
+struct ViewConcreteString : InterfaceString
+{
+    ViewConcreteString(std::string_view text, bool upper) : m_Text(text), m_Upper(upper) {}
+    static std::string factoryRegistrationKey() { return "viewConcreteString"; }
+    int getVal() const noexcept override { return static_cast<int>(m_Text.size()) * (m_Upper ? -1 : 1); }
+    std::string_view text() const noexcept { return m_Text; }
+
+private:
+    std::string_view m_Text;
+    bool m_Upper{false};
+};
+
+struct RefConcreteString : InterfaceString
+{
+    RefConcreteString(int& val) : m_Val(val) {}
+    static std::string factoryRegistrationKey() { return "refConcreteString"; }
+    int getVal() const noexcept override { return m_Val; }
+
+private:
+    int m_Val{0};
+};
+
+TEST(FactoryTest, ReferenceArgsRegistrationTest)
+{
+    // types constructed from lvalue references are still registrable, they just can't be created from records
+    HGSFactory<InterfaceString, std::string> factory;
+    factory.registerType<RefConcreteString, int&>();
+    std::vector<std::byte> buffer;
+    writeRecord(buffer, RefConcreteString::factoryRegistrationKey(), 3);
+    EXPECT_THAT(factory.createFromRecord({buffer.data(), buffer.size()}), IsNull());
+}
+
+TEST(FactoryTest, RecordCreationTest)
+{
+    InterfaceIntInternalRegistredFactory factory;
+    factory.registerTypes();
+    std::vector<std::byte> buffer;
+    writeRecord(buffer, ConcreteInt::factoryRegistrationKey(), 20);
+    auto concrete = factory.createFromRecord({buffer.data(), buffer.size()});
+    ASSERT_THAT(concrete, NotNull());
+    EXPECT_THAT(concrete->getVal(), Eq(20));
+    EXPECT_THAT(factory.createFromRecord({buffer.data(), buffer.size() - 1}), IsNull());
+
+    buffer.clear();
+    writeRecord(buffer, 1, 7, 1);
+    writeRecord(buffer, 2, 7);
+    writeRecord(buffer, ConcreteInt::factoryRegistrationKey(), 8, 1);
+    writeRecord(buffer, ConcreteInt::factoryRegistrationKey(), 9);
+    const auto fullSize = buffer.size();
+    writeRecord(buffer, ConcreteInt::factoryRegistrationKey(), 10);
+    std::vector<std::unique_ptr<InterfaceInt>> objects;
+    const auto count = factory.createAll({buffer.data(), buffer.size() - 1}, [&](auto object)
+    {
+        objects.push_back(std::move(object));
+    });
+    EXPECT_THAT(count, Eq(4u));
+    ASSERT_THAT(objects.size(), Eq(4u));
+    ASSERT_THAT(objects[0], NotNull());
+    EXPECT_THAT(objects[0]->getVal(), Eq(7));
+    EXPECT_THAT(objects[1], IsNull());
+    EXPECT_THAT(objects[2], IsNull());
+    ASSERT_THAT(objects[3], NotNull());
+    EXPECT_THAT(objects[3]->getVal(), Eq(9));
+
+    const auto views = splitRecords({buffer.data(), fullSize}, 2);
+    ASSERT_THAT(views.size(), Eq(2u));
+    std::size_t splitCount = 0;
+    for (const auto& view : views)
+    {
+        splitCount += factory.createAll(view, [](auto) {});
+    }
+    EXPECT_THAT(splitCount, Eq(4u));
+
+    buffer.clear();
+    writeRecord(buffer, SecondConcreteString::factoryRegistrationKey(), 5, 1);
+    auto secondConcrete = InterfaceStringFactory::createFromRecord({buffer.data(), buffer.size()});
+    ASSERT_THAT(secondConcrete, NotNull());
+    EXPECT_THAT(secondConcrete->getVal(), Eq(5));
+
+    HGSFactory<InterfaceString, std::string> viewFactory;
+    viewFactory.registerType<ViewConcreteString, std::string_view, bool>();
+    buffer.clear();
+    writeRecord(buffer, ViewConcreteString::factoryRegistrationKey(), std::string_view("view text"), true);
+    auto viewConcrete = viewFactory.createFromRecord({buffer.data(), buffer.size()});
+    ASSERT_THAT(viewConcrete, NotNull());
+    EXPECT_THAT(viewConcrete->getVal(), Eq(-9));
+    // the argument points into the record buffer, it isn't copied
+    const auto text = static_cast<ViewConcreteString*>(viewConcrete.get())->text();
+    EXPECT_THAT(text, Eq("view text"));
+    EXPECT_THAT(static_cast<const void*>(text.data()), Ge(static_cast<const void*>(buffer.data())));
+    EXPECT_THAT(static_cast<const void*>(text.data() + text.size()),
+                Le(static_cast<const void*>(buffer.data() + buffer.size())));
+
+    buffer.back() = std::byte{2};
+    EXPECT_THAT(viewFactory.createFromRecord({buffer.data(), buffer.size()}), IsNull());
+}
+
+struct InterfaceReplicated
+{
+    virtual ~InterfaceReplicated() = default;
+    virtual int getVal() const noexcept = 0;
+};
+
+struct ConcreteReplicated : InterfaceReplicated
+{
+    ConcreteReplicated(int val) : m_Val(val) {}
+    static std::string factoryRegistrationKey() { return "replicated"; }
+    int getVal() const noexcept override { return m_Val; }
+
+private:
+    int m_Val{0};
+};
+
+using InterfaceReplicatedFactory = StaticHGSFactory<InterfaceReplicated, std::string>;
+
+template<typename StaticFactoryImplT>
+struct impl_pattern::StaticHGSFactoryImplTestAccess
+{
+    static const void* currentRegistry() noexcept { return &StaticFactoryImplT::getReadFactory(); }
+    static const void* masterRegistry() noexcept { return &StaticFactoryImplT::getFactory(); }
+};
+
+TEST(FactoryTest, ReplicaTopologyTest)
+{
+    const ReplicaTopology topology({{0, 2}, {1, 3}, {}});
+    EXPECT_THAT(topology.groupCount(), Eq(3u));
+    EXPECT_THAT(topology.cpus(1), ElementsAre(1, 3));
+    {
+        ReplicaGroupScope scope(2);
+        EXPECT_THAT(topology.currentGroup(), Eq(2u));
+        {
+            ReplicaGroupScope innerScope(1);
+            EXPECT_THAT(topology.currentGroup(), Eq(1u));
+        }
+        EXPECT_THAT(topology.currentGroup(), Eq(2u));
+    }
+    EXPECT_THAT(topology.currentGroup(), Lt(2u));
+    EXPECT_THAT(ReplicaTopology::emulated(4).groupCount(), Eq(4u));
+    EXPECT_THAT(ReplicaTopology::numaNodes().groupCount(), Ge(1u));
+}
+
+TEST(FactoryTest, ReplicatedStaticFactoryTest)
+{
+    InterfaceReplicatedFactory::registerType<ConcreteReplicated, int>();
+    EXPECT_THAT(InterfaceReplicatedFactory::replicaCount(), Eq(0u));
+    InterfaceReplicatedFactory::replicate(ReplicaTopology::emulated(3));
+    ASSERT_THAT(InterfaceReplicatedFactory::replicaCount(), Eq(3u));
+
+    using ReplicatedAccess = impl_pattern::StaticHGSFactoryImplTestAccess<
+        impl_pattern::StaticHGSFactoryImpl<InterfaceReplicated, std::string>>;
+    std::vector<int> values(InterfaceReplicatedFactory::replicaCount(), 0);
+    std::vector<const void*> registries(values.size(), nullptr);
+    std::vector<std::thread> workers;
+    for (std::size_t group = 0; group < values.size(); ++group)
+    {
+        workers.emplace_back([group, &values, &registries]
+        {
+            ReplicaGroupScope scope(group);
+            registries[group] = ReplicatedAccess::currentRegistry();
+            auto concrete = InterfaceReplicatedFactory::create(ConcreteReplicated::factoryRegistrationKey(),
+                                                               static_cast<int>(group) + 1);
+            auto concreteValue = InterfaceReplicatedFactory::createValue<16>(ConcreteReplicated::factoryRegistrationKey(),
+                                                                             static_cast<int>(group) + 1);
+            if (concrete && concreteValue)
+            {
+                values[group] = concrete->getVal() + concreteValue->getVal();
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    EXPECT_THAT(values, ElementsAre(2, 4, 6));
+    const auto master = ReplicatedAccess::masterRegistry();
+    EXPECT_THAT(registries, Each(AllOf(NotNull(), Ne(master))));
+    // every replica lives in pages of its own, apart from the master and from each other
+    std::set<std::uintptr_t> pages{reinterpret_cast<std::uintptr_t>(master) / impl_pattern::ReplicaPageResource::pageSize()};
+    for (const auto* registry : registries)
+    {
+        pages.insert(reinterpret_cast<std::uintptr_t>(registry) / impl_pattern::ReplicaPageResource::pageSize());
+    }
+    EXPECT_THAT(pages.size(), Eq(registries.size() + 1));
+    EXPECT_THAT(InterfaceReplicatedFactory::create("unknown", 1), IsNull());
+}
+
 int main(int argc, char **argv)
 {
     InitGoogleTest(&argc, argv);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include "heterogeneous_factory.h"
+#include <string>
+
+using namespace pattern;
+
+namespace
+{
+
+struct BenchInterface
+{
+    virtual ~BenchInterface() = default;
+    virtual int getVal() const noexcept = 0;
+};
+
+struct SmallObject : BenchInterface
+{
+    SmallObject(int a, int b) : mA(a), mB(b) {}
+    static std::string factoryRegistrationKey() { return "small"; }
+    int getVal() const noexcept override { return mA + mB; }
+
+private:
+    int mA;
+    int mB;
+};
+
+class BenchFactory : public HGSFactory<BenchInterface, std::string>
+{
+public:
+    BenchFactory()
+    {
+        registerType<SmallObject, int, int>();
+    }
+};
+
+constexpr std::size_t kChurnBatch = 64;
+
+void BM_CreateUniquePtr(benchmark::State& state)
+{
+    const BenchFactory factory;
+    const auto key = SmallObject::factoryRegistrationKey();
+    for (auto _ : state)
+    {
+        std::unique_ptr<BenchInterface> objects[kChurnBatch];
+        for (std::size_t i = 0; i < kChurnBatch; ++i)
+        {
+            objects[i] = factory.create(key, static_cast<int>(i), 1);
+        }
+        benchmark::DoNotOptimize(objects);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kChurnBatch));
+}
+BENCHMARK(BM_CreateUniquePtr);
+
+void BM_CreatePolyValueInline(benchmark::State& state)
+{
+    const BenchFactory factory;
+    const auto key = SmallObject::factoryRegistrationKey();
+    for (auto _ : state)
+    {
+        PolyValue<BenchInterface, 32> objects[kChurnBatch];
+        for (std::size_t i = 0; i < kChurnBatch; ++i)
+        {
+            objects[i] = factory.createValue<32>(key, static_cast<int>(i), 1);
+        }
+        benchmark::DoNotOptimize(objects);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kChurnBatch));
+}
+BENCHMARK(BM_CreatePolyValueInline);
+
+void BM_CreatePolyValueHeap(benchmark::State& state)
+{
+    const BenchFactory factory;
+    const auto key = SmallObject::factoryRegistrationKey();
+    for (auto _ : state)
+    {
+        PolyValue<BenchInterface, 1> objects[kChurnBatch];
+        for (std::size_t i = 0; i < kChurnBatch; ++i)
+        {
+            objects[i] = factory.createValue<1>(key, static_cast<int>(i), 1);
+        }
+        benchmark::DoNotOptimize(objects);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kChurnBatch));
+}
+BENCHMARK(BM_CreatePolyValueHeap);
+
+} // namespace
@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+#include "heterogeneous_factory.h"
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace pattern;
+
+namespace
+{
+
+struct Message
+{
+    virtual ~Message() = default;
+    virtual std::size_t weight() const noexcept = 0;
+};
+
+struct PriceMessage : Message
+{
+    PriceMessage(std::int64_t id, double price) : mId(id), mPrice(price) {}
+    static std::string factoryRegistrationKey() { return "price"; }
+    std::size_t weight() const noexcept override { return static_cast<std::size_t>(mId) + (mPrice > 0 ? 1 : 0); }
+
+private:
+    std::int64_t mId;
+    double mPrice;
+};
+
+struct NoteMessage : Message
+{
+    NoteMessage(std::int64_t id, std::string_view text) : mId(id), mText(text) {}
+    static std::string factoryRegistrationKey() { return "note"; }
+    std::size_t weight() const noexcept override { return static_cast<std::size_t>(mId) + mText.size(); }
+
+private:
+    std::int64_t mId;
+    std::string_view mText;
+};
+
+class MessageFactory : public HGSFactory<Message, std::string>
+{
+public:
+    MessageFactory()
+    {
+        registerType<PriceMessage, std::int64_t, double>();
+        registerType<NoteMessage, std::int64_t, std::string_view>();
+    }
+};
+
+constexpr std::int64_t kRecordCount = 1 << 20;
+
+const std::vector<std::byte>& recordBuffer()
+{
+    static const auto buffer = []
+    {
+        std::vector<std::byte> records;
+        for (std::int64_t i = 0; i < kRecordCount; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                writeRecord(records, PriceMessage::factoryRegistrationKey(), i, 1.5);
+            }
+            else
+            {
+                writeRecord(records, NoteMessage::factoryRegistrationKey(), i, std::string_view("note text"));
+            }
+        }
+        return records;
+    }();
+    return buffer;
+}
+
+void BM_CreateAllRecords(benchmark::State& state)
+{
+    const MessageFactory factory;
+    const auto& buffer = recordBuffer();
+    const auto threadCount = static_cast<std::size_t>(state.range(0));
+    const auto views = splitRecords({buffer.data(), buffer.size()}, threadCount);
+    for (auto _ : state)
+    {
+        std::atomic<std::size_t> total{0};
+        std::vector<std::thread> threads;
+        for (const auto& view : views)
+        {
+            threads.emplace_back([&factory, &total, view]
+            {
+                std::size_t weight = 0;
+                factory.createAll(view, [&weight](auto message)
+                {
+                    weight += message ? message->weight() : 0;
+                });
+                total += weight;
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        benchmark::DoNotOptimize(total.load());
+    }
+    state.SetItemsProcessed(state.iterations() * kRecordCount);
+}
+BENCHMARK(BM_CreateAllRecords)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_DecodeThenCreate(benchmark::State& state)
+{
+    const MessageFactory factory;
+    const auto& buffer = recordBuffer();
+    for (auto _ : state)
+    {
+        std::size_t weight = 0;
+        RecordReader reader({buffer.data(), buffer.size()});
+        while (!reader.empty())
+        {
+            RecordReader body(reader.takeRecord());
+            const auto key = RecordCodec<std::string>::decode(body);
+            const auto id = RecordCodec<std::int64_t>::decode(body);
+            std::unique_ptr<Message> message;
+            if (key == PriceMessage::factoryRegistrationKey())
+            {
+                message = factory.create(key, id, RecordCodec<double>::decode(body));
+            }
+            else
+            {
+                message = factory.create(key, id, RecordCodec<std::string_view>::decode(body));
+            }
+            weight += message ? message->weight() : 0;
+        }
+        benchmark::DoNotOptimize(weight);
+    }
+    state.SetItemsProcessed(state.iterations() * kRecordCount);
+}
+BENCHMARK(BM_DecodeThenCreate)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include "heterogeneous_factory.h"
+#include <string>
+#include <vector>
+
+using namespace pattern;
+
+namespace
+{
+
+template<typename PolicyT>
+struct RegistryInterface
+{
+    virtual ~RegistryInterface() = default;
+    virtual int getVal() const noexcept = 0;
+};
+
+template<typename PolicyT>
+struct RegistryObject : RegistryInterface<PolicyT>
+{
+    RegistryObject(int val) : mVal(val) {}
+    int getVal() const noexcept override { return mVal; }
+
+private:
+    int mVal;
+};
+
+template<typename KeyT>
+KeyT makeKey(int index);
+
+template<>
+std::string makeKey<std::string>(int index)
+{
+    return "product" + std::to_string(index);
+}
+
+template<>
+int makeKey<int>(int index)
+{
+    return index * 7919;
+}
+
+} // namespace
+
+template<typename PolicyT, typename KeyT>
+struct pattern::FactoryRegistryPolicy<RegistryInterface<PolicyT>, KeyT>
+{
+    using type = PolicyT;
+};
+
+namespace
+{
+
+template<typename PolicyT, typename KeyT>
+void BM_RegistryLookup(benchmark::State& state)
+{
+    const auto count = static_cast<int>(state.range(0));
+    HGSFactory<RegistryInterface<PolicyT>, KeyT> factory;
+    std::vector<KeyT> keys;
+    for (int i = 0; i < count; ++i)
+    {
+        keys.push_back(makeKey<KeyT>(i));
+        factory.template registerType<RegistryObject<PolicyT>, int>(keys.back());
+    }
+    std::size_t index = 0;
+    for (auto _ : state)
+    {
+        auto object = factory.template createValue<16>(keys[index], 1);
+        benchmark::DoNotOptimize(object);
+        index = index + 1 == keys.size() ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(BM_RegistryLookup, registry_policy::Hash, std::string)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_RegistryLookup, registry_policy::Small, std::string)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_RegistryLookup, registry_policy::Hash, int)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_RegistryLookup, registry_policy::Small, int)->Arg(4)->Arg(16)->Arg(64);
+
+} // namespace
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+#include "heterogeneous_static_factory.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace pattern;
+
+namespace
+{
+
+template<bool Replicated>
+struct ReplicaInterface
+{
+    virtual ~ReplicaInterface() = default;
+    virtual int getVal() const noexcept = 0;
+};
+
+constexpr std::size_t kProductCount = 16;
+
+std::string productKey(std::size_t index)
+{
+    return "replica_product" + std::to_string(index);
+}
+
+template<bool Replicated, std::size_t Index>
+struct ReplicaObject : ReplicaInterface<Replicated>
+{
+    ReplicaObject(int val) : mVal(val) {}
+    static std::string factoryRegistrationKey() { return productKey(Index); }
+    int getVal() const noexcept override { return mVal; }
+
+private:
+    int mVal;
+};
+
+template<bool Replicated>
+class ReplicaFactory : public StaticHGSFactory<ReplicaInterface<Replicated>, std::string>
+{
+public:
+    static const std::string& key(std::size_t index)
+    {
+        static const auto keys = []
+        {
+            std::vector<std::string> result;
+            for (std::size_t i = 0; i < kProductCount; ++i)
+            {
+                result.push_back(productKey(i));
+            }
+            return result;
+        }();
+        return keys[index % keys.size()];
+    }
+
+    static void setUp()
+    {
+        static const bool initialized = []
+        {
+            registerProducts(std::make_index_sequence<kProductCount>{});
+            if (Replicated)
+            {
+                ReplicaFactory::replicate(ReplicaTopology::numaNodes());
+            }
+            return true;
+        }();
+        (void)initialized;
+    }
+
+private:
+    template<std::size_t... Indices>
+    static void registerProducts(std::index_sequence<Indices...>)
+    {
+        (ReplicaFactory::template registerType<ReplicaObject<Replicated, Indices>, int>(), ...);
+    }
+};
+
+template<bool Replicated>
+void BM_ReplicaCreate(benchmark::State& state)
+{
+    using FactoryT = ReplicaFactory<Replicated>;
+    FactoryT::setUp();
+    std::size_t index = static_cast<std::size_t>(state.thread_index());
+    for (auto _ : state)
+    {
+        auto object = FactoryT::template createValue<16>(FactoryT::key(index++), 1);
+        benchmark::DoNotOptimize(object);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(BM_ReplicaCreate, false)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReplicaCreate, true)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace
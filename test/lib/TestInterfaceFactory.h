@@ -2,6 +2,7 @@
 
 #include "heterogeneous_factory.h"
 #include "TestInterface.h"
+#include <string>
 
 class TestInterfaceFactory : public pattern::HGSFactory<TestInterface, std::string>
 {